@@ -7,7 +7,11 @@ FetchContent_Declare(
 
 # Set pfunit CMake options **before** it's made available
 set(SKIP_MPI OFF CACHE BOOL "" FORCE)
-set(SKIP_OPENMP ON CACHE BOOL "" FORCE)
+if (MPAS_ENABLE_OPENMP)
+    set(SKIP_OPENMP OFF CACHE BOOL "" FORCE)
+else ()
+    set(SKIP_OPENMP ON CACHE BOOL "" FORCE)
+endif ()
 set(SKIP_FHAMCREST ON CACHE BOOL "" FORCE)
 set(ENABLE_TESTS OFF CACHE BOOL "" FORCE)
 
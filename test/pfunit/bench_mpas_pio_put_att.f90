@@ -0,0 +1,105 @@
+!> @brief Attribute-write latency benchmark for `mpas_pio_put_att`.
+!>
+!> Writes N_ATTS global attributes to a file in data mode, first one at a
+!> time through mpas_pio_put_att and then through a single batched flush
+!> (mpas_att_batch_mod), and reports the mean latency per attribute (max over
+!> ranks) on rank 0. Run it under mpirun with an increasing number of ranks.
+!>
+!> Usage: bench_mpas_pio_put_att [netcdf|pnetcdf] [niotasks]
+!> niotasks defaults to 1, i.e. rank 0 is the only aggregator. Exits with
+!> SKIP_CODE when PIO was built without the requested iotype.
+program bench_mpas_pio_put_att
+    use mpi
+    use pio
+    use mpas_io, only : mpas_pio_put_att
+    use mpas_att_batch_mod
+
+    implicit none
+
+    integer, parameter :: N_ATTS = 200
+    integer, parameter :: SKIP_CODE = 77
+    character(len = *), parameter :: FILENAME = 'bench_att.nc'
+
+    type(iosystem_desc_t) :: iosys
+    type(file_desc_t) :: file
+    type(mpas_att_batch_type) :: batch
+    character(len = 32) :: arg, att_name
+    integer :: ierr, retVal, myRank, ntasks, niotasks, stride, iotype, i
+    real(kind = 8) :: t_start, t_single, t_batched
+
+    call MPI_Init(ierr)
+    call MPI_Comm_rank(MPI_COMM_WORLD, myRank, ierr)
+    call MPI_Comm_size(MPI_COMM_WORLD, ntasks, ierr)
+
+    iotype = PIO_iotype_netcdf
+    if (command_argument_count() >= 1) then
+        call get_command_argument(1, arg)
+        if (trim(arg) == 'pnetcdf') iotype = PIO_iotype_pnetcdf
+    end if
+    niotasks = 1
+    if (command_argument_count() >= 2) then
+        call get_command_argument(2, arg)
+        read(arg, *) niotasks
+    end if
+    niotasks = max(1, min(niotasks, ntasks))
+    stride = max(1, ntasks / niotasks)
+
+    if (.not. PIO_iotype_available(iotype)) then
+        if (myRank == 0) write(*, '(a)') 'PIO was built without the requested iotype, skipping'
+        call MPI_Finalize(ierr)
+        stop SKIP_CODE
+    end if
+
+    call PIO_init(myRank, MPI_COMM_WORLD, niotasks, 0, stride, PIO_rearr_subset, iosys, base = 0)
+    call PIO_seterrorhandling(iosys, PIO_bcast_error)
+
+    retVal = PIO_createfile(iosys, file, iotype, FILENAME, PIO_clobber)
+    if (retVal /= PIO_noerr) then
+        if (myRank == 0) write(*, '(a)') 'Failed to create ' // FILENAME // ' with the requested iotype'
+        call PIO_finalize(iosys, ierr)
+        call MPI_Finalize(ierr)
+        stop 1
+    end if
+    retVal = PIO_enddef(file)
+
+    ! One attribute at a time, as the model does today
+    call MPI_Barrier(MPI_COMM_WORLD, ierr)
+    t_start = MPI_Wtime()
+    do i = 1, N_ATTS
+        write(att_name, '(a,i0)') 'single_attr_', i
+        retVal = mpas_pio_put_att(file, 0, trim(att_name), i)
+    end do
+    call MPI_Barrier(MPI_COMM_WORLD, ierr)
+    t_single = MPI_Wtime() - t_start
+
+    ! Queued on every rank, applied in a single header update
+    call MPI_Barrier(MPI_COMM_WORLD, ierr)
+    t_start = MPI_Wtime()
+    do i = 1, N_ATTS
+        write(att_name, '(a,i0)') 'batched_attr_', i
+        call mpas_att_batch_put(batch, 0, trim(att_name), i)
+    end do
+    retVal = mpas_att_batch_flush(file, batch)
+    call MPI_Barrier(MPI_COMM_WORLD, ierr)
+    t_batched = MPI_Wtime() - t_start
+
+    call MPI_Allreduce(MPI_IN_PLACE, t_single, 1, MPI_DOUBLE_PRECISION, MPI_MAX, MPI_COMM_WORLD, ierr)
+    call MPI_Allreduce(MPI_IN_PLACE, t_batched, 1, MPI_DOUBLE_PRECISION, MPI_MAX, MPI_COMM_WORLD, ierr)
+
+    if (myRank == 0) then
+        write(*, '(a)') 'ranks iotasks  iotype  single(us/att) batched(us/att)  speedup'
+        write(*, '(i5,i8,a9,f16.2,f16.2,f9.2)') ntasks, niotasks, &
+                merge('  pnetcdf', '   netcdf', iotype == PIO_iotype_pnetcdf), &
+                1.0d6 * t_single / N_ATTS, 1.0d6 * t_batched / N_ATTS, &
+                t_single / max(t_batched, tiny(1.0d0))
+    end if
+
+    call PIO_closefile(file)
+    call PIO_finalize(iosys, ierr)
+    if (myRank == 0) then
+        open(unit = 99, file = FILENAME, status = 'old', iostat = ierr)
+        if (ierr == 0) close(99, status = 'delete')
+    end if
+    call MPI_Finalize(ierr)
+
+end program bench_mpas_pio_put_att
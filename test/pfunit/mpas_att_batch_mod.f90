@@ -0,0 +1,155 @@
+!> @brief Batched attribute writes for PIO files.
+!>
+!> Attribute writes are queued on every compute rank with mpas_att_batch_put
+!> and applied by mpas_att_batch_flush inside a single define-mode section, so
+!> the header is rewritten once per flush instead of once per attribute. A later
+!> put of the same (varid, name) replaces the queued value, which keeps the
+!> overwrite/extend semantics of mpas_pio_put_att.
+!>
+!> Only the PIO I/O tasks touch the file: with PIO_iotype_netcdf the header is
+!> written by the I/O root alone, and with PIO_iotype_pnetcdf by the I/O tasks
+!> chosen at PIO_init (niotasks/stride), which act as the aggregators. As with
+!> all PIO attribute calls, every rank must queue the same attributes in the
+!> same order, and the flush is collective over the I/O system.
+module mpas_att_batch_mod
+    use pio
+
+    implicit none
+
+    private
+    public :: mpas_att_batch_type, mpas_att_batch_put, mpas_att_batch_flush
+
+    integer, parameter :: ATT_TEXT = 1
+    integer, parameter :: ATT_INT = 2
+    integer, parameter :: ATT_INT_ARRAY = 3
+
+    type :: att_entry
+        integer :: varid
+        integer :: att_type
+        character(len = :), allocatable :: name
+        character(len = :), allocatable :: text
+        integer, dimension(:), allocatable :: ints
+    end type att_entry
+
+    type :: mpas_att_batch_type
+        integer :: n = 0
+        type(att_entry), dimension(:), allocatable :: entries
+    end type mpas_att_batch_type
+
+    interface mpas_att_batch_put
+        module procedure put_text
+        module procedure put_int
+        module procedure put_int_array
+    end interface mpas_att_batch_put
+
+contains
+
+    ! Returns the entry for (varid, name), appending a new one if needed
+    function find_or_add(batch, varid, name) result(i)
+        type(mpas_att_batch_type), intent(inout) :: batch
+        integer, intent(in) :: varid
+        character(len = *), intent(in) :: name
+        integer :: i
+        type(att_entry), dimension(:), allocatable :: grown
+
+        do i = 1, batch%n
+            if (batch%entries(i)%varid == varid .and. batch%entries(i)%name == name) return
+        end do
+
+        if (.not. allocated(batch%entries)) then
+            allocate(batch%entries(16))
+        else if (batch%n == size(batch%entries)) then
+            allocate(grown(2 * size(batch%entries)))
+            grown(1:batch%n) = batch%entries(1:batch%n)
+            call move_alloc(grown, batch%entries)
+        end if
+
+        batch%n = batch%n + 1
+        i = batch%n
+        batch%entries(i)%varid = varid
+        batch%entries(i)%name = name
+    end function find_or_add
+
+    subroutine put_text(batch, varid, name, value)
+        type(mpas_att_batch_type), intent(inout) :: batch
+        integer, intent(in) :: varid
+        character(len = *), intent(in) :: name
+        character(len = *), intent(in) :: value
+        integer :: i
+
+        i = find_or_add(batch, varid, name)
+        batch%entries(i)%att_type = ATT_TEXT
+        batch%entries(i)%text = value
+    end subroutine put_text
+
+    subroutine put_int(batch, varid, name, value)
+        type(mpas_att_batch_type), intent(inout) :: batch
+        integer, intent(in) :: varid
+        character(len = *), intent(in) :: name
+        integer, intent(in) :: value
+        integer :: i
+
+        i = find_or_add(batch, varid, name)
+        batch%entries(i)%att_type = ATT_INT
+        batch%entries(i)%ints = [value]
+    end subroutine put_int
+
+    subroutine put_int_array(batch, varid, name, value)
+        type(mpas_att_batch_type), intent(inout) :: batch
+        integer, intent(in) :: varid
+        character(len = *), intent(in) :: name
+        integer, dimension(:), intent(in) :: value
+        integer :: i
+
+        i = find_or_add(batch, varid, name)
+        batch%entries(i)%att_type = ATT_INT_ARRAY
+        batch%entries(i)%ints = value
+    end subroutine put_int_array
+
+    !> Applies all queued attributes with one redef/enddef pair and empties the
+    !> batch. The file is expected to be in data mode; a caller that already
+    !> has it in define mode passes in_define_mode = .true., and the file is
+    !> then left in define mode. Returns PIO_noerr or the first PIO error
+    !> encountered.
+    function mpas_att_batch_flush(file, batch, in_define_mode) result(ierr)
+        type(file_desc_t), intent(inout) :: file
+        type(mpas_att_batch_type), intent(inout) :: batch
+        logical, intent(in), optional :: in_define_mode
+        integer :: ierr
+        integer :: i, local_ierr
+        logical :: enter_define_mode
+
+        ierr = PIO_noerr
+        if (batch%n == 0) return
+
+        enter_define_mode = .true.
+        if (present(in_define_mode)) enter_define_mode = .not. in_define_mode
+
+        if (enter_define_mode) then
+            ierr = PIO_redef(file)
+            if (ierr /= PIO_noerr) return
+        end if
+
+        do i = 1, batch%n
+            associate (entry => batch%entries(i))
+                select case (entry%att_type)
+                case (ATT_TEXT)
+                    local_ierr = PIO_put_att(file, entry%varid, entry%name, entry%text)
+                case (ATT_INT)
+                    local_ierr = PIO_put_att(file, entry%varid, entry%name, entry%ints(1))
+                case default
+                    local_ierr = PIO_put_att(file, entry%varid, entry%name, entry%ints)
+                end select
+            end associate
+            if (ierr == PIO_noerr) ierr = local_ierr
+        end do
+
+        if (enter_define_mode) then
+            local_ierr = PIO_enddef(file)
+            if (ierr == PIO_noerr) ierr = local_ierr
+        end if
+
+        batch%n = 0
+    end function mpas_att_batch_flush
+
+end module mpas_att_batch_mod
@@ -0,0 +1,452 @@
+#define _GNU_SOURCE
+#include "mpas_log_scan.h"
+#include <ctype.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Longest numeric token we parse; anything longer is not a number we expect
+#define NUMBER_BUF_LEN 64
+
+static void summary_init(mpas_log_summary *summary) {
+    memset(summary, 0, sizeof(*summary));
+    summary->error_messages = -1;
+    summary->critical_error_messages = -1;
+}
+
+static int starts_with(const char *line, size_t len, const char *key) {
+    size_t key_len = strlen(key);
+    return len >= key_len && memcmp(line, key, key_len) == 0;
+}
+
+static int is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Values are parsed straight from the mapped line, one token at a time, so a
+// line of any length keeps its trailing values. Each token is copied into a
+// small NUL-terminated buffer so that strtol/strtod never run past the end of
+// the mapping.
+
+// Returns the start of the next token in [*p, end) and its length in *len,
+// advancing *p past it; NULL if there is none
+static const char *next_token(const char **p, const char *end, size_t *len) {
+    const char *q = *p;
+    while (q < end && is_blank(*q)) {
+        q++;
+    }
+    const char *start = q;
+    while (q < end && !is_blank(*q)) {
+        q++;
+    }
+    *p = q;
+    *len = (size_t) (q - start);
+    return *len > 0 ? start : NULL;
+}
+
+// Parses a token that must be a number in its entirety
+static int token_to_double(const char *tok, size_t len, double *value) {
+    char buf[NUMBER_BUF_LEN];
+    char *end;
+    if (len == 0 || len >= NUMBER_BUF_LEN) {
+        return 0;
+    }
+    memcpy(buf, tok, len);
+    buf[len] = '\0';
+    *value = strtod(buf, &end);
+    return end == buf + len;
+}
+
+// Parses the leading integer of a token
+static int token_to_long(const char *tok, size_t len, long *value) {
+    char buf[NUMBER_BUF_LEN];
+    char *end;
+    if (len == 0 || len >= NUMBER_BUF_LEN) {
+        return 0;
+    }
+    memcpy(buf, tok, len);
+    buf[len] = '\0';
+    *value = strtol(buf, &end, 10);
+    return end != buf;
+}
+
+// Parses the next token of [*p, end) as a double
+static int next_double(const char **p, const char *end, double *value) {
+    size_t len;
+    const char *tok = next_token(p, end, &len);
+    return tok != NULL && token_to_double(tok, len, value);
+}
+
+static int int_after_equals(const char *line, size_t len) {
+    const char *eq = memchr(line, '=', len);
+    if (eq == NULL) {
+        return -1;
+    }
+    const char *p = eq + 1;
+    size_t tok_len;
+    const char *tok = next_token(&p, line + len, &tok_len);
+    long value;
+    if (tok == NULL || !token_to_long(tok, tok_len, &value)) {
+        return -1;
+    }
+    return (int) value;
+}
+
+static void add_timer(
+    mpas_log_summary *summary, const char *name, double total, int calls
+) {
+    for (int i = 0; i < summary->n_timers; i++) {
+        mpas_log_timer *t = &summary->timers[i];
+        if (strcmp(t->name, name) == 0) {
+            if (total > t->total) {
+                t->total = total;
+            }
+            if (calls > t->calls) {
+                t->calls = calls;
+            }
+            return;
+        }
+    }
+    if (summary->n_timers == MPAS_LOG_SCAN_MAX_TIMERS) {
+        return;
+    }
+    mpas_log_timer *t = &summary->timers[summary->n_timers++];
+    strncpy(t->name, name, MPAS_LOG_SCAN_TIMER_NAME_LEN - 1);
+    t->name[MPAS_LOG_SCAN_TIMER_NAME_LEN - 1] = '\0';
+    t->total = total;
+    t->calls = calls;
+}
+
+// A timer table row is "<index> <name ...> <total> <calls> <min> ...", where
+// the name may contain spaces and everything after it is numeric. The numeric
+// columns are found by walking back from the end of the line, so neither the
+// length of the name nor of the line limits what is parsed.
+// Returns 0 if the line is not a timer row.
+static int parse_timer_row(
+    mpas_log_summary *summary, const char *line, size_t len
+) {
+    const char *end = line + len;
+    const char *p = line;
+    size_t tok_len;
+
+    const char *index = next_token(&p, end, &tok_len);
+    if (index == NULL || !isdigit((unsigned char) index[0])) {
+        return 0;
+    }
+    const char *name_start = p;
+    while (name_start < end && is_blank(*name_start)) {
+        name_start++;
+    }
+
+    // Walk the trailing numeric tokens right to left; the first name token is
+    // never taken as a value, even if it looks numeric
+    const char *values = NULL;
+    int n_values = 0;
+    const char *q = end;
+    while (q > name_start) {
+        while (q > name_start && is_blank(q[-1])) {
+            q--;
+        }
+        const char *tok_end = q;
+        while (q > name_start && !is_blank(q[-1])) {
+            q--;
+        }
+        double unused;
+        if (q == tok_end || q == name_start ||
+            !token_to_double(q, (size_t) (tok_end - q), &unused)) {
+            break;
+        }
+        values = q;
+        n_values++;
+    }
+    if (n_values < 2) {
+        return 0;
+    }
+
+    // Join the name tokens with single spaces, truncating to the struct size
+    char name[MPAS_LOG_SCAN_TIMER_NAME_LEN];
+    size_t name_len = 0;
+    const char *r = name_start;
+    const char *tok;
+    while ((tok = next_token(&r, values, &tok_len)) != NULL) {
+        if (name_len > 0 && name_len < sizeof(name) - 1) {
+            name[name_len++] = ' ';
+        }
+        size_t room = sizeof(name) - 1 - name_len;
+        size_t n = tok_len < room ? tok_len : room;
+        memcpy(name + name_len, tok, n);
+        name_len += n;
+    }
+    name[name_len] = '\0';
+
+    double total;
+    long calls;
+    const char *v = values;
+    if (!next_double(&v, end, &total)) {
+        return 0;
+    }
+    tok = next_token(&v, end, &tok_len);
+    if (tok == NULL || !token_to_long(tok, tok_len, &calls)) {
+        return 0;
+    }
+    add_timer(summary, name, total, (int) calls);
+    return 1;
+}
+
+// Returns 1 if both values were parsed into range, 0 otherwise
+static int parse_range(double range[2], const char *line, size_t len) {
+    // Skip "global min, max u"
+    const char *p = line + strlen("global min, max u");
+    double lo, hi;
+    if (!next_double(&p, line + len, &lo) || !next_double(&p, line + len, &hi)) {
+        return 0;
+    }
+    range[0] = lo;
+    range[1] = hi;
+    return 1;
+}
+
+static void scan_buffer(
+    mpas_log_summary *summary, const char *data, size_t size
+) {
+    const char *p = data;
+    const char *data_end = data + size;
+    int in_timer_table = 0;
+
+    while (p < data_end) {
+        const char *nl = memchr(p, '\n', (size_t) (data_end - p));
+        const char *line_end = nl != NULL ? nl : data_end;
+        const char *line = p;
+        p = line_end + 1;
+
+        while (line < line_end && (*line == ' ' || *line == '\t')) {
+            line++;
+        }
+        size_t len = (size_t) (line_end - line);
+        if (len == 0) {
+            in_timer_table = 0;
+            continue;
+        }
+
+        if (in_timer_table) {
+            if (parse_timer_row(summary, line, len)) {
+                continue;
+            }
+            in_timer_table = 0;
+        }
+
+        // Dispatch on the first character so most lines cost one compare
+        switch (*line) {
+            case 'E':
+                if (starts_with(line, len, "Error messages")) {
+                    summary->error_messages = int_after_equals(line, len);
+                }
+                break;
+            case 'C':
+                if (starts_with(line, len, "Critical error messages")) {
+                    summary->critical_error_messages = int_after_equals(
+                        line, len
+                    );
+                }
+                break;
+            case 'T':
+                if (starts_with(line, len, "Timing for integration step:")) {
+                    const char *v = line + strlen(
+                        "Timing for integration step:"
+                    );
+                    double t;
+                    if (!next_double(&v, line + len, &t)) {
+                        break;
+                    }
+                    if (summary->n_timesteps == 0 || t < summary->step_time_min) {
+                        summary->step_time_min = t;
+                    }
+                    if (summary->n_timesteps == 0 || t > summary->step_time_max) {
+                        summary->step_time_max = t;
+                    }
+                    summary->step_time_total += t;
+                    summary->n_timesteps++;
+                }
+                break;
+            case 'g':
+                if (starts_with(line, len, "global min, max u")) {
+                    if (parse_range(summary->u_range, line, len)) {
+                        summary->has_u_range = 1;
+                    }
+                } else if (starts_with(line, len, "global min, max w")) {
+                    if (parse_range(summary->w_range, line, len)) {
+                        summary->has_w_range = 1;
+                    }
+                }
+                break;
+            case 't':
+                if (starts_with(line, len, "timer_name")) {
+                    in_timer_table = 1;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+int mpas_log_scan_file(const char *path, mpas_log_summary *summary) {
+    struct stat st;
+
+    summary_init(summary);
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return 1;
+    }
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return 1;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        summary->files_scanned = 1;
+        return 0;
+    }
+
+    void *data = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return 1;
+    }
+    madvise(data, (size_t) st.st_size, MADV_SEQUENTIAL);
+
+    scan_buffer(summary, data, (size_t) st.st_size);
+    summary->files_scanned = 1;
+
+    munmap(data, (size_t) st.st_size);
+    return 0;
+}
+
+typedef struct {
+    const char *prefix;
+    int nranks;
+    int stride;
+    int first;
+    mpas_log_summary *summaries;
+    int *status;
+} scan_task;
+
+static void *scan_worker(void *arg) {
+    scan_task *task = arg;
+    char path[4096];
+
+    for (int rank = task->first; rank < task->nranks; rank += task->stride) {
+        snprintf(path, sizeof(path), "%s.%04d.out", task->prefix, rank);
+        task->status[rank] = mpas_log_scan_file(path, &task->summaries[rank]);
+    }
+    return NULL;
+}
+
+static void merge_summary(mpas_log_summary *into, const mpas_log_summary *from) {
+    if (from->error_messages >= 0) {
+        into->error_messages = (into->error_messages < 0 ? 0 : into->error_messages)
+                               + from->error_messages;
+    }
+    if (from->critical_error_messages >= 0) {
+        into->critical_error_messages =
+                (into->critical_error_messages < 0 ? 0 : into->critical_error_messages)
+                + from->critical_error_messages;
+    }
+    if (from->n_timesteps > 0) {
+        if (into->n_timesteps == 0 || from->step_time_min < into->step_time_min) {
+            into->step_time_min = from->step_time_min;
+        }
+        if (into->n_timesteps == 0 || from->step_time_max > into->step_time_max) {
+            into->step_time_max = from->step_time_max;
+        }
+        if (from->n_timesteps > into->n_timesteps) {
+            into->n_timesteps = from->n_timesteps;
+            into->step_time_total = from->step_time_total;
+        }
+    }
+    // Ranks are merged in order, so the first one with a range wins
+    if (!into->has_u_range && from->has_u_range) {
+        memcpy(into->u_range, from->u_range, sizeof(into->u_range));
+        into->has_u_range = 1;
+    }
+    if (!into->has_w_range && from->has_w_range) {
+        memcpy(into->w_range, from->w_range, sizeof(into->w_range));
+        into->has_w_range = 1;
+    }
+    for (int i = 0; i < from->n_timers; i++) {
+        add_timer(
+            into, from->timers[i].name, from->timers[i].total,
+            from->timers[i].calls
+        );
+    }
+    into->files_scanned += from->files_scanned;
+}
+
+int mpas_log_scan_files(
+    const char *prefix, int nranks, int nthreads, mpas_log_summary *summary
+) {
+    summary_init(summary);
+    if (nranks <= 0) {
+        return 1;
+    }
+    if (nthreads <= 0) {
+        nthreads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (nthreads > nranks) {
+        nthreads = nranks;
+    }
+    if (nthreads < 1) {
+        nthreads = 1;
+    }
+
+    mpas_log_summary *summaries = malloc(sizeof(*summaries) * (size_t) nranks);
+    int *status = malloc(sizeof(*status) * (size_t) nranks);
+    pthread_t *threads = malloc(sizeof(*threads) * (size_t) nthreads);
+    scan_task *tasks = malloc(sizeof(*tasks) * (size_t) nthreads);
+    if (summaries == NULL || status == NULL || threads == NULL || tasks == NULL) {
+        free(summaries);
+        free(status);
+        free(threads);
+        free(tasks);
+        return 1;
+    }
+
+    for (int i = 0; i < nthreads; i++) {
+        tasks[i] = (scan_task) {prefix, nranks, nthreads, i, summaries, status};
+    }
+    // The calling thread takes the first share of the ranks itself
+    int started = 0;
+    for (int i = 1; i < nthreads; i++) {
+        if (pthread_create(&threads[i], NULL, scan_worker, &tasks[i]) != 0) {
+            break;
+        }
+        started = i;
+    }
+    for (int i = started + 1; i < nthreads; i++) {
+        scan_worker(&tasks[i]);
+    }
+    scan_worker(&tasks[0]);
+    for (int i = 1; i <= started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    // Merge in rank order so that u/w ranges come from the lowest rank
+    for (int rank = 0; rank < nranks; rank++) {
+        if (status[rank] == 0) {
+            merge_summary(summary, &summaries[rank]);
+        }
+    }
+    int ierr = status[0];
+
+    free(summaries);
+    free(status);
+    free(threads);
+    free(tasks);
+    return ierr;
+}
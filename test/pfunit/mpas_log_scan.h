@@ -0,0 +1,51 @@
+#ifndef MPAS_LOG_SCAN_H
+#define MPAS_LOG_SCAN_H
+
+// Structured summary of MPAS log files (log.<core>.NNNN.out).
+//
+// Each file is memory-mapped and scanned once with no limit on line length;
+// the files of different ranks are scanned concurrently and merged. The
+// layout of these structs is mirrored by bind(C) types in mpas_test_utils_mod.
+
+#define MPAS_LOG_SCAN_MAX_TIMERS 128
+#define MPAS_LOG_SCAN_TIMER_NAME_LEN 64
+
+typedef struct {
+    char name[MPAS_LOG_SCAN_TIMER_NAME_LEN];
+    double total; // max over ranks
+    int calls;    // max over ranks
+} mpas_log_timer;
+
+typedef struct {
+    int files_scanned;
+    // Summed over ranks; -1 if no file contained the message summary
+    int error_messages;
+    int critical_error_messages;
+    // "Timing for integration step" lines. n_timesteps and step_time_total
+    // both come from the rank with the most steps (the lowest such rank on a
+    // tie); step_time_min and step_time_max are taken over all ranks
+    int n_timesteps;
+    double step_time_total;
+    double step_time_min;
+    double step_time_max;
+    // Last "global min, max u/w" values of the lowest rank that reports them;
+    // only meaningful when the matching has_*_range flag is nonzero
+    double u_range[2];
+    double w_range[2];
+    int has_u_range;
+    int has_w_range;
+    int n_timers;
+    mpas_log_timer timers[MPAS_LOG_SCAN_MAX_TIMERS];
+} mpas_log_summary;
+
+// Returns 0 on success, nonzero if the file cannot be opened or mapped
+int mpas_log_scan_file(const char *path, mpas_log_summary *summary);
+
+// Scans <prefix>.0000.out ... <prefix>.<nranks-1>.out using up to nthreads
+// threads (0 selects one per online CPU). Ranks that did not write a log are
+// skipped; returns nonzero only if the rank 0 log cannot be scanned.
+int mpas_log_scan_files(
+    const char *prefix, int nranks, int nthreads, mpas_log_summary *summary
+);
+
+#endif //MPAS_LOG_SCAN_H
@@ -1,5 +1,44 @@
 module mpas_test_utils_mod
-    public :: file_exists, delete_file
+    use iso_c_binding, only: c_int, c_double, c_char, c_null_char
+
+    public :: file_exists, delete_file, scan_mpas_logs
+
+    ! Mirrors MPAS_LOG_SCAN_* and the structs in mpas_log_scan.h
+    integer, parameter :: MPAS_LOG_SCAN_MAX_TIMERS = 128
+    integer, parameter :: MPAS_LOG_SCAN_TIMER_NAME_LEN = 64
+
+    type, bind(C) :: mpas_log_timer_t
+        character(kind = c_char) :: name(MPAS_LOG_SCAN_TIMER_NAME_LEN)
+        real(c_double) :: total
+        integer(c_int) :: calls
+    end type mpas_log_timer_t
+
+    type, bind(C) :: mpas_log_summary_t
+        integer(c_int) :: files_scanned
+        integer(c_int) :: error_messages
+        integer(c_int) :: critical_error_messages
+        integer(c_int) :: n_timesteps
+        real(c_double) :: step_time_total
+        real(c_double) :: step_time_min
+        real(c_double) :: step_time_max
+        real(c_double) :: u_range(2)
+        real(c_double) :: w_range(2)
+        integer(c_int) :: has_u_range
+        integer(c_int) :: has_w_range
+        integer(c_int) :: n_timers
+        type(mpas_log_timer_t) :: timers(MPAS_LOG_SCAN_MAX_TIMERS)
+    end type mpas_log_summary_t
+
+    interface
+        function mpas_log_scan_files(prefix, nranks, nthreads, summary) bind(C, name = "mpas_log_scan_files")
+            import :: c_int, c_char, mpas_log_summary_t
+            character(kind = c_char), dimension(*), intent(in) :: prefix
+            integer(c_int), value :: nranks, nthreads
+            type(mpas_log_summary_t), intent(out) :: summary
+            integer(c_int) :: mpas_log_scan_files
+        end function mpas_log_scan_files
+    end interface
+
 contains
     ! Helper: Check if a file exists
     logical function file_exists(path)
@@ -18,31 +57,15 @@ contains
         end if
     end subroutine delete_file
 
-    function extract_int_after_equals(line) result(value)
-        character(len = *), intent(in) :: line
-        integer :: value
-        integer :: eq_pos, istart, iend
-        character(len = 32) :: numstr
+    ! Helper: Scan <prefix>.NNNN.out for all nranks log files into a structured summary
+    function scan_mpas_logs(prefix, nranks, summary) result(ierr)
+        character(len = *), intent(in) :: prefix
+        integer, intent(in) :: nranks
+        type(mpas_log_summary_t), intent(out) :: summary
+        integer :: ierr
 
-        eq_pos = index(line, "=")
-        if (eq_pos == 0) then
-            value = -1  ! or some default error value
-            return
-        end if
-        istart = eq_pos + 1
-        do while (istart <= len_trim(line) .and. line(istart:istart) == ' ')
-            istart = istart + 1
-        end do
-        iend = istart
-        do while (iend <= len_trim(line) .and. line(iend:iend) >= '0' .and. line(iend:iend) <= '9')
-            iend = iend + 1
-        end do
-        if (iend > istart) then
-            read(line(istart:iend - 1), *) value
-        else
-            value = -1
-        end if
-    end function extract_int_after_equals
+        ierr = mpas_log_scan_files(trim(prefix) // c_null_char, int(nranks, c_int), 0_c_int, summary)
+    end function scan_mpas_logs
 
 end module mpas_test_utils_mod
 
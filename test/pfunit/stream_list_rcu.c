@@ -0,0 +1,214 @@
+#include "stream_list_rcu.h"
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct stream_list_rcu_node {
+    char name[STREAM_LIST_RCU_NAME_LEN];
+    int id;
+    _Atomic(struct stream_list_rcu_node *) next;
+    // Only touched by writers, under writer_lock
+    struct stream_list_rcu_node *retired_next;
+    unsigned long retire_epoch;
+} stream_list_rcu_node;
+
+struct stream_list_rcu {
+    _Atomic(stream_list_rcu_node *) head;
+    atomic_int n_items;
+    atomic_ulong global_epoch;
+    // 0 means the slot is quiescent, otherwise the epoch it entered in
+    atomic_ulong reader_epoch[STREAM_LIST_RCU_MAX_READERS];
+    pthread_mutex_t writer_lock;
+    stream_list_rcu_node *retired;
+};
+
+static void read_lock(stream_list_rcu *list, int slot) {
+    unsigned long epoch = atomic_load(&list->global_epoch);
+    // seq_cst store followed by a full fence: a writer that scans the slots
+    // after this point sees the announcement, and our traversal below cannot
+    // start before the announcement is visible
+    atomic_store(&list->reader_epoch[slot], epoch);
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+static void read_unlock(stream_list_rcu *list, int slot) {
+    atomic_store_explicit(
+        &list->reader_epoch[slot], 0UL, memory_order_release
+    );
+}
+
+// Frees retired nodes that no reader can still reference. Called with
+// writer_lock held; never waits for readers.
+static void reclaim(stream_list_rcu *list) {
+    unsigned long min_active = ULONG_MAX;
+    for (int i = 0; i < STREAM_LIST_RCU_MAX_READERS; i++) {
+        unsigned long e = atomic_load(&list->reader_epoch[i]);
+        if (e != 0 && e < min_active) {
+            min_active = e;
+        }
+    }
+
+    stream_list_rcu_node **link = &list->retired;
+    while (*link != NULL) {
+        stream_list_rcu_node *node = *link;
+        if (node->retire_epoch <= min_active) {
+            *link = node->retired_next;
+            // Poison before freeing so that a premature reclaim shows up as
+            // a failed lookup rather than silently reading stale data
+            memset(node->name, 0, sizeof(node->name));
+            node->id = -1;
+            free(node);
+        } else {
+            link = &node->retired_next;
+        }
+    }
+}
+
+stream_list_rcu *stream_list_rcu_create(void) {
+    stream_list_rcu *list = malloc(sizeof(*list));
+    if (list == NULL) {
+        return NULL;
+    }
+    atomic_init(&list->head, NULL);
+    atomic_init(&list->n_items, 0);
+    atomic_init(&list->global_epoch, 1UL);
+    for (int i = 0; i < STREAM_LIST_RCU_MAX_READERS; i++) {
+        atomic_init(&list->reader_epoch[i], 0UL);
+    }
+    pthread_mutex_init(&list->writer_lock, NULL);
+    list->retired = NULL;
+    return list;
+}
+
+void stream_list_rcu_destroy(stream_list_rcu *list) {
+    if (list == NULL) {
+        return;
+    }
+    stream_list_rcu_node *node = atomic_load(&list->head);
+    while (node != NULL) {
+        stream_list_rcu_node *next = atomic_load(&node->next);
+        free(node);
+        node = next;
+    }
+    node = list->retired;
+    while (node != NULL) {
+        stream_list_rcu_node *next = node->retired_next;
+        free(node);
+        node = next;
+    }
+    pthread_mutex_destroy(&list->writer_lock);
+    free(list);
+}
+
+int stream_list_rcu_insert(stream_list_rcu *list, const char *name, int id) {
+    pthread_mutex_lock(&list->writer_lock);
+
+    // Writers are serialized, so relaxed loads see the latest structure
+    _Atomic(stream_list_rcu_node *) *link = &list->head;
+    stream_list_rcu_node *node;
+    while ((node = atomic_load_explicit(link, memory_order_relaxed)) != NULL) {
+        if (strcmp(node->name, name) == 0) {
+            pthread_mutex_unlock(&list->writer_lock);
+            return STREAM_LIST_RCU_DUPLICATE;
+        }
+        link = &node->next;
+    }
+
+    node = malloc(sizeof(*node));
+    if (node == NULL) {
+        pthread_mutex_unlock(&list->writer_lock);
+        return STREAM_LIST_RCU_NOMEM;
+    }
+    strncpy(node->name, name, STREAM_LIST_RCU_NAME_LEN - 1);
+    node->name[STREAM_LIST_RCU_NAME_LEN - 1] = '\0';
+    node->id = id;
+    atomic_init(
+        &node->next, atomic_load_explicit(&list->head, memory_order_relaxed)
+    );
+    node->retired_next = NULL;
+    node->retire_epoch = 0;
+
+    // Push at the head rather than appending at the tail as
+    // MPAS_stream_list_insert does: a reader already in the list can then
+    // never reach the new node, so a traversal only visits nodes that existed
+    // when it started. The release store publishes the initialized node.
+    atomic_store_explicit(&list->head, node, memory_order_release);
+    atomic_fetch_add(&list->n_items, 1);
+
+    pthread_mutex_unlock(&list->writer_lock);
+    return STREAM_LIST_RCU_NOERR;
+}
+
+int stream_list_rcu_remove(stream_list_rcu *list, const char *name) {
+    pthread_mutex_lock(&list->writer_lock);
+
+    _Atomic(stream_list_rcu_node *) *link = &list->head;
+    stream_list_rcu_node *node;
+    while ((node = atomic_load_explicit(link, memory_order_relaxed)) != NULL) {
+        if (strcmp(node->name, name) == 0) {
+            break;
+        }
+        link = &node->next;
+    }
+    if (node == NULL) {
+        pthread_mutex_unlock(&list->writer_lock);
+        return STREAM_LIST_RCU_NOT_FOUND;
+    }
+
+    // Unlink but leave node->next intact so readers standing on the node can
+    // still walk off it
+    atomic_store(link, atomic_load_explicit(&node->next, memory_order_relaxed));
+    atomic_fetch_sub(&list->n_items, 1);
+
+    node->retire_epoch = atomic_fetch_add(&list->global_epoch, 1UL) + 1UL;
+    node->retired_next = list->retired;
+    list->retired = node;
+    reclaim(list);
+
+    pthread_mutex_unlock(&list->writer_lock);
+    return STREAM_LIST_RCU_NOERR;
+}
+
+int stream_list_rcu_length(stream_list_rcu *list) {
+    return atomic_load(&list->n_items);
+}
+
+int stream_list_rcu_lookup(
+    stream_list_rcu *list, int slot, const char *name, int *id
+) {
+    int found = 0;
+
+    read_lock(list, slot);
+    stream_list_rcu_node *node = atomic_load_explicit(
+        &list->head, memory_order_acquire
+    );
+    while (node != NULL) {
+        if (strcmp(node->name, name) == 0) {
+            *id = node->id;
+            found = 1;
+            break;
+        }
+        node = atomic_load_explicit(&node->next, memory_order_acquire);
+    }
+    read_unlock(list, slot);
+
+    return found;
+}
+
+int stream_list_rcu_count(stream_list_rcu *list, int slot) {
+    int count = 0;
+
+    read_lock(list, slot);
+    stream_list_rcu_node *node = atomic_load_explicit(
+        &list->head, memory_order_acquire
+    );
+    while (node != NULL) {
+        count++;
+        node = atomic_load_explicit(&node->next, memory_order_acquire);
+    }
+    read_unlock(list, slot);
+
+    return count;
+}
@@ -0,0 +1,51 @@
+#ifndef STREAM_LIST_RCU_H
+#define STREAM_LIST_RCU_H
+
+// Concurrent variant of MPAS_stream_list_type.
+//
+// Readers never take a lock: they announce the current epoch in their own
+// reader slot, traverse the list with acquire loads, and clear the slot when
+// done. Writers are serialized by a mutex, publish insertions and unlinks with
+// release stores, and defer freeing of removed nodes until no reader that
+// could still hold a reference remains in an older epoch.
+//
+// New streams are inserted at the head, so a traversal visits at most the
+// nodes that were in the list when it started and always terminates; in
+// exchange the list order is newest first, unlike MPAS_stream_list_type.
+
+// Return codes mirror MPAS_STREAM_LIST_{NOERR,DUPLICATE,NOT_FOUND}; NOMEM has
+// no MPAS counterpart and is returned when a node cannot be allocated
+#define STREAM_LIST_RCU_NOERR 0
+#define STREAM_LIST_RCU_DUPLICATE (-1)
+#define STREAM_LIST_RCU_NOT_FOUND (-2)
+#define STREAM_LIST_RCU_NOMEM (-3)
+
+#define STREAM_LIST_RCU_NAME_LEN 512 // StrKIND in MPAS
+#define STREAM_LIST_RCU_MAX_READERS 64
+
+typedef struct stream_list_rcu stream_list_rcu;
+
+stream_list_rcu *stream_list_rcu_create(void);
+
+// Must only be called once no reader or writer is using the list
+void stream_list_rcu_destroy(stream_list_rcu *list);
+
+// Writer side; safe to call concurrently with readers
+int stream_list_rcu_insert(stream_list_rcu *list, const char *name, int id);
+
+int stream_list_rcu_remove(stream_list_rcu *list, const char *name);
+
+int stream_list_rcu_length(stream_list_rcu *list);
+
+// Reader side; never blocks. slot must be unique per concurrently reading
+// thread and in [0, STREAM_LIST_RCU_MAX_READERS)
+int stream_list_rcu_lookup(
+    stream_list_rcu *list, int slot, const char *name, int *id
+);
+
+// Number of nodes seen by one traversal. Under concurrent writes this is not
+// a snapshot: it may include streams removed during the traversal, but never
+// more than the list held when the traversal started.
+int stream_list_rcu_count(stream_list_rcu *list, int slot);
+
+#endif //STREAM_LIST_RCU_H
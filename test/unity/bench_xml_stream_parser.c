@@ -0,0 +1,147 @@
+// Corpus-driven throughput benchmark for the XML streams parser entry points.
+//
+// For every file named on the command line, each entry point is run
+// repeatedly for at least MIN_SECONDS and its throughput is reported in MB/s:
+//
+//   syntax  xml_syntax_check over the whole file
+//   tags    parse_xml_tag + parse_xml_tag_name over every tag in the file
+//   ezxml   ezxml_parse_str
+//   check   check_streams on the parsed tree (streams documents only)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ezxml.h"
+#include "xml_stream_parser.h"
+
+#define MIN_SECONDS 0.2
+
+void fmt_err(const char *msg) {
+    (void) msg;
+}
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + 1.0e-9 * (double) ts.tv_nsec;
+}
+
+static char *read_file(const char *path, size_t *size) {
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL) {
+        return NULL;
+    }
+    fseek(fp, 0, SEEK_END);
+    long len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    char *buf = len >= 0 ? malloc((size_t) len + 1) : NULL;
+    if (buf != NULL) {
+        *size = fread(buf, 1, (size_t) len, fp);
+        buf[*size] = '\0';
+    }
+    fclose(fp);
+    return buf;
+}
+
+static void bench_syntax(const char *data, size_t size, char *work) {
+    memcpy(work, data, size + 1);
+    xml_syntax_check(work, size);
+}
+
+static void bench_tags(const char *data, size_t size, char *work) {
+    static char *tag = NULL;
+    static char *tag_name = NULL;
+    static size_t capacity = 0;
+    if (capacity < size + 1) {
+        free(tag);
+        free(tag_name);
+        capacity = size + 1;
+        tag = malloc(capacity);
+        tag_name = malloc(capacity);
+    }
+
+    memcpy(work, data, size + 1);
+    size_t pos = 0;
+    int line = 1;
+    int start_line;
+    while (pos < size) {
+        size_t tag_len;
+        size_t offset = parse_xml_tag(
+            work + pos, size - pos, tag, &tag_len, &line, &start_line
+        );
+        if (offset == 0) {
+            break;
+        }
+        parse_xml_tag_name(tag, tag_name);
+        pos += offset;
+    }
+}
+
+static void bench_ezxml(const char *data, size_t size, char *work) {
+    memcpy(work, data, size + 1);
+    ezxml_free(ezxml_parse_str(work, size));
+}
+
+static void bench_check(const char *data, size_t size, char *work) {
+    memcpy(work, data, size + 1);
+    ezxml_t root = ezxml_parse_str(work, size);
+    const char *root_name = ezxml_name(root);
+    if (root_name != NULL && strcmp(root_name, "streams") == 0) {
+        check_streams(root);
+    }
+    ezxml_free(root);
+}
+
+// Returns MB/s of fn over data
+static double throughput(
+    void (*fn)(const char *, size_t, char *), const char *data, size_t size,
+    char *work
+) {
+    long iterations = 0;
+    double start = now();
+    double elapsed;
+    do {
+        fn(data, size, work);
+        iterations++;
+        elapsed = now() - start;
+    } while (elapsed < MIN_SECONDS);
+    return (double) size * (double) iterations / elapsed / 1.0e6;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s corpus_file...\n", argv[0]);
+        return 1;
+    }
+
+    printf(
+        "%-40s %10s %10s %10s %10s %10s\n", "file", "bytes", "syntax",
+        "tags", "ezxml", "check"
+    );
+    for (int i = 1; i < argc; i++) {
+        size_t size = 0;
+        char *data = read_file(argv[i], &size);
+        if (data == NULL) {
+            fprintf(stderr, "cannot read %s\n", argv[i]);
+            return 1;
+        }
+        char *work = malloc(size + 1);
+
+        const char *name = strrchr(argv[i], '/');
+        name = name != NULL ? name + 1 : argv[i];
+        printf(
+            "%-40s %10zu %10.2f %10.2f %10.2f %10.2f\n", name, size,
+            throughput(bench_syntax, data, size, work),
+            throughput(bench_tags, data, size, work),
+            throughput(bench_ezxml, data, size, work),
+            throughput(bench_check, data, size, work)
+        );
+
+        free(work);
+        free(data);
+    }
+    printf("(MB/s)\n");
+    return 0;
+}
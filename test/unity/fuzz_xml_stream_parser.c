@@ -0,0 +1,226 @@
+// Fuzz harness for the XML streams parser entry points.
+//
+// Built with clang and -fsanitize=fuzzer this is a libFuzzer target; built
+// with MPAS_FUZZ_STANDALONE it is a plain program that runs each file named
+// on the command line (or stdin), which is what AFL and the ctest corpus
+// replay use. Every input is checked for:
+//
+//   - memory errors in parse_xml_tag, parse_xml_tag_name, xml_syntax_check
+//     and check_streams: each call gets its own heap buffer, so ASan flags any
+//     overrun. xml_syntax_check and parse_xml_tag take a length and get an
+//     unterminated copy of exactly that many bytes, so reading one byte past
+//     the end is caught. Tag buffers are sized to the input; parse_xml_tag_name
+//     gets a buffer of XML_TAG_NAME_LEN bytes, the fixed size MPAS callers
+//     pass, so a tag name that does not fit is reported instead of hidden;
+//   - agreement between the tag-level entry points and ezxml: a document with
+//     a single top-level element that xml_syntax_check accepts must parse with
+//     ezxml, and the tag walk of parse_xml_tag must find at least one tag per
+//     ezxml element, with names that parse_xml_tag_name agrees on. ezxml also
+//     rejects a missing root or several top-level elements, which
+//     xml_syntax_check does not look for, so those documents are not compared.
+//     check_streams has no independent reference here, so its result is not
+//     compared; it is only run for memory errors.
+//
+// A violated agreement aborts so that the fuzzer records the input.
+//
+// xml_stream_parser.c and ezxml.c are compiled into this target from the MPAS
+// sources with the same instrumentation, so coverage and ASan reach inside the
+// parser. Its fmt_err and other log calls end in mpas_log_write_c, which needs
+// the Fortran logger; the build renames that call to the quiet stub below.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ezxml.h"
+#include "xml_stream_parser.h"
+
+// Size of the tag name buffer that MPAS passes to parse_xml_tag_name
+#ifndef XML_TAG_NAME_LEN
+#define XML_TAG_NAME_LEN 256
+#endif
+
+static void disagree(const char *what, const uint8_t *data, size_t size) {
+    fprintf(stderr, "xml_stream_parser entry points disagree: %s\n", what);
+    fprintf(stderr, "input (%zu bytes): %.*s\n", size, (int) size, (const char *) data);
+    abort();
+}
+
+// The MPAS logger is not initialized in this harness; see the CMake target
+void fuzz_log_write_c(const char *message, const char *message_type) {
+    (void) message;
+    (void) message_type;
+}
+
+// Exactly size bytes with no terminator, for entry points that take a length
+static char *copy_input(const uint8_t *data, size_t size) {
+    char *buf = malloc(size);
+    if (buf == NULL) {
+        abort();
+    }
+    memcpy(buf, data, size);
+    return buf;
+}
+
+// NUL-terminated copy, for ezxml_parse_str, which parses in place
+static char *copy_input_str(const uint8_t *data, size_t size) {
+    char *buf = malloc(size + 1);
+    if (buf == NULL) {
+        abort();
+    }
+    memcpy(buf, data, size);
+    buf[size] = '\0';
+    return buf;
+}
+
+static int count_elements(ezxml_t node) {
+    int n = 0;
+    for (; node != NULL; node = node->ordered) {
+        n += 1 + count_elements(node->child);
+    }
+    return n;
+}
+
+// Walks every tag with parse_xml_tag and checks it against
+// parse_xml_tag_name; returns the number of tags found and sets *n_roots to
+// the number of elements that are not nested in another element
+static int walk_tags(const uint8_t *data, size_t size, int *n_roots) {
+    char *buf = copy_input(data, size);
+    // A tag can be no longer than the input it came from
+    char *tag = malloc(size + 1);
+    char *tag_name = malloc(XML_TAG_NAME_LEN);
+    size_t pos = 0;
+    int line = 1;
+    int start_line;
+    int n_tags = 0;
+    int depth = 0;
+
+    *n_roots = 0;
+    while (pos < size) {
+        size_t tag_len = 0;
+        size_t offset = parse_xml_tag(
+            buf + pos, size - pos, tag, &tag_len, &line, &start_line
+        );
+        if (offset == 0) {
+            break;
+        }
+        if (offset > size - pos) {
+            disagree("parse_xml_tag advanced past the end of the input", data, size);
+        }
+        if (tag_len > size - pos || strlen(tag) != tag_len) {
+            disagree("parse_xml_tag returned an inconsistent tag length", data, size);
+        }
+        if (start_line > line) {
+            disagree("parse_xml_tag start line is after the current line", data, size);
+        }
+
+        parse_xml_tag_name(tag, tag_name);
+        size_t name_len = strnlen(tag_name, XML_TAG_NAME_LEN);
+        if (name_len == XML_TAG_NAME_LEN) {
+            disagree("parse_xml_tag_name overflowed its tag name buffer", data, size);
+        }
+        if (name_len > tag_len || strncmp(tag, tag_name, name_len) != 0) {
+            disagree("parse_xml_tag_name is not a prefix of the tag", data, size);
+        }
+
+        // Comments, declarations and processing instructions are not elements
+        if (tag_len > 0 && tag[0] != '!' && tag[0] != '?') {
+            if (tag[0] == '/') {
+                depth--;
+            } else {
+                if (depth == 0) {
+                    (*n_roots)++;
+                }
+                if (tag[tag_len - 1] != '/') {
+                    depth++;
+                }
+            }
+        }
+
+        n_tags++;
+        pos += offset;
+    }
+
+    free(tag_name);
+    free(tag);
+    free(buf);
+    return n_tags;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+
+    char *buf = copy_input(data, size);
+    int syntax_ok = xml_syntax_check(buf, size) == 0;
+    free(buf);
+
+    int n_roots;
+    int n_tags = walk_tags(data, size, &n_roots);
+
+    buf = copy_input_str(data, size);
+    ezxml_t root = ezxml_parse_str(buf, size);
+    int ezxml_ok = root != NULL && ezxml_error(root)[0] == '\0';
+
+    if (syntax_ok && n_roots == 1 && !ezxml_ok) {
+        disagree("xml_syntax_check accepted input that ezxml rejects", data, size);
+    }
+    if (syntax_ok && ezxml_ok) {
+        if (n_tags < count_elements(root)) {
+            disagree("parse_xml_tag found fewer tags than ezxml elements", data, size);
+        }
+        // check_streams only ever sees documents that passed the syntax check
+        const char *root_name = ezxml_name(root);
+        if (root_name != NULL && strcmp(root_name, "streams") == 0) {
+            (void) check_streams(root);
+        }
+    }
+
+    ezxml_free(root);
+    free(buf);
+    return 0;
+}
+
+#ifdef MPAS_FUZZ_STANDALONE
+static int run_file(FILE *fp) {
+    size_t capacity = 4096;
+    size_t size = 0;
+    uint8_t *data = malloc(capacity);
+    size_t n;
+
+    while (data != NULL && (n = fread(data + size, 1, capacity - size, fp)) > 0) {
+        size += n;
+        if (size == capacity) {
+            capacity *= 2;
+            data = realloc(data, capacity);
+        }
+    }
+    if (data == NULL) {
+        return 1;
+    }
+    LLVMFuzzerTestOneInput(data, size);
+    free(data);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        return run_file(stdin);
+    }
+    for (int i = 1; i < argc; i++) {
+        FILE *fp = fopen(argv[i], "rb");
+        if (fp == NULL) {
+            fprintf(stderr, "cannot open %s\n", argv[i]);
+            return 1;
+        }
+        int ierr = run_file(fp);
+        fclose(fp);
+        if (ierr) {
+            return ierr;
+        }
+    }
+    return 0;
+}
+#endif
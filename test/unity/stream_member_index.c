@@ -0,0 +1,413 @@
+#include "stream_member_index.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MSGSIZE 256
+
+// Provided by the MPAS framework, as for xml_stream_parser.c
+void fmt_err(const char *msg);
+
+// Open-addressing string -> int table; slots hold index + 1, 0 means empty
+typedef struct {
+    int *slots;
+    size_t capacity; // power of two
+} intern_table;
+
+typedef struct {
+    int *ids;
+    int n;
+    int capacity;
+} id_list;
+
+typedef struct {
+    char *name; // NULL for a stream without a name attribute
+    id_list members;
+} stream_entry;
+
+struct stream_member_index {
+    // Interned field names, indexed by field ID
+    char **field_names;
+    int n_fields;
+    int field_capacity;
+    intern_table fields;
+
+    // <file> includes, each read once
+    char **file_names;
+    id_list *file_members;
+    int n_files;
+    int file_capacity;
+    intern_table files;
+
+    stream_entry *streams;
+    int n_streams;
+};
+
+static uint64_t hash_string(const char *s) {
+    // FNV-1a
+    uint64_t h = 1469598103934665603ULL;
+    for (; *s != '\0'; s++) {
+        h ^= (unsigned char) *s;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static int table_init(intern_table *table, size_t capacity) {
+    table->capacity = capacity;
+    table->slots = calloc(capacity, sizeof(int));
+    return table->slots == NULL;
+}
+
+// Returns the slot holding name, or the empty slot where it belongs
+static size_t table_probe(
+    const intern_table *table, char *const *names, const char *name
+) {
+    size_t mask = table->capacity - 1;
+    size_t i = (size_t) hash_string(name) & mask;
+    while (table->slots[i] != 0 &&
+           strcmp(names[table->slots[i] - 1], name) != 0) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+static int table_grow(intern_table *table, char *const *names, int n) {
+    intern_table grown;
+    if (table_init(&grown, table->capacity * 2)) {
+        return 1;
+    }
+    for (int id = 0; id < n; id++) {
+        grown.slots[table_probe(&grown, names, names[id])] = id + 1;
+    }
+    free(table->slots);
+    *table = grown;
+    return 0;
+}
+
+static int id_list_push(id_list *list, int id) {
+    if (list->n == list->capacity) {
+        int capacity = list->capacity == 0 ? 16 : list->capacity * 2;
+        int *ids = realloc(list->ids, sizeof(int) * (size_t) capacity);
+        if (ids == NULL) {
+            return 1;
+        }
+        list->ids = ids;
+        list->capacity = capacity;
+    }
+    list->ids[list->n++] = id;
+    return 0;
+}
+
+// Returns the field ID of name, interning it if needed, or -1 on failure
+static int intern_field(stream_member_index *index, const char *name) {
+    size_t slot = table_probe(&index->fields, index->field_names, name);
+    if (index->fields.slots[slot] != 0) {
+        return index->fields.slots[slot] - 1;
+    }
+
+    if (index->n_fields == index->field_capacity) {
+        int capacity = index->field_capacity == 0 ? 64 : index->field_capacity * 2;
+        char **names = realloc(
+            index->field_names, sizeof(char *) * (size_t) capacity
+        );
+        if (names == NULL) {
+            return -1;
+        }
+        index->field_names = names;
+        index->field_capacity = capacity;
+    }
+    char *copy = strdup(name);
+    if (copy == NULL) {
+        return -1;
+    }
+    int id = index->n_fields++;
+    index->field_names[id] = copy;
+    index->fields.slots[slot] = id + 1;
+
+    // Keep the load factor at or below one half
+    if ((size_t) index->n_fields * 2 > index->fields.capacity &&
+        table_grow(&index->fields, index->field_names, index->n_fields)) {
+        return -1;
+    }
+    return id;
+}
+
+// Reads a <file> include: one field name per whitespace-separated token
+static int read_member_file(
+    stream_member_index *index, const char *path, id_list *members
+) {
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        return 1;
+    }
+
+    int ierr = 0;
+    char name[1024];
+    while (fscanf(fp, "%1023s", name) == 1) {
+        int id = intern_field(index, name);
+        if (id < 0 || id_list_push(members, id)) {
+            ierr = 1;
+            break;
+        }
+    }
+    fclose(fp);
+    return ierr;
+}
+
+// Returns the file's position in index->file_members, reading it on first
+// use, or -1 if it cannot be read
+static int lookup_file(stream_member_index *index, const char *path) {
+    size_t slot = table_probe(&index->files, index->file_names, path);
+    if (index->files.slots[slot] != 0) {
+        return index->files.slots[slot] - 1;
+    }
+
+    if (index->n_files == index->file_capacity) {
+        int capacity = index->file_capacity == 0 ? 8 : index->file_capacity * 2;
+        char **names = realloc(
+            index->file_names, sizeof(char *) * (size_t) capacity
+        );
+        if (names == NULL) {
+            return -1;
+        }
+        index->file_names = names;
+        id_list *members = realloc(
+            index->file_members, sizeof(id_list) * (size_t) capacity
+        );
+        if (members == NULL) {
+            return -1;
+        }
+        index->file_members = members;
+        index->file_capacity = capacity;
+    }
+
+    int file = index->n_files;
+    id_list *members = &index->file_members[file];
+    memset(members, 0, sizeof(*members));
+    index->file_names[file] = strdup(path);
+    if (index->file_names[file] == NULL) {
+        return -1;
+    }
+    if (read_member_file(index, path, members)) {
+        free(index->file_names[file]);
+        free(members->ids);
+        return -1;
+    }
+    index->n_files++;
+    index->files.slots[slot] = file + 1;
+
+    if ((size_t) index->n_files * 2 > index->files.capacity &&
+        table_grow(&index->files, index->file_names, index->n_files)) {
+        return -1;
+    }
+    return file;
+}
+
+static int is_stream(ezxml_t node) {
+    const char *name = ezxml_name(node);
+    return strcmp(name, "stream") == 0 || strcmp(name, "immutable_stream") == 0;
+}
+
+// Adds id to the stream unless it is already a member. seen[id] holds the
+// 1-based index of the last stream that added the field.
+static int add_member(
+    stream_entry *stream, int stream_stamp, int **seen, int *seen_capacity,
+    int id
+) {
+    if (id >= *seen_capacity) {
+        int capacity = *seen_capacity == 0 ? 64 : *seen_capacity;
+        while (capacity <= id) {
+            capacity *= 2;
+        }
+        int *grown = realloc(*seen, sizeof(int) * (size_t) capacity);
+        if (grown == NULL) {
+            return 1;
+        }
+        memset(
+            grown + *seen_capacity, 0,
+            sizeof(int) * (size_t) (capacity - *seen_capacity)
+        );
+        *seen = grown;
+        *seen_capacity = capacity;
+    }
+    if ((*seen)[id] == stream_stamp) {
+        return 0;
+    }
+    (*seen)[id] = stream_stamp;
+    return id_list_push(&stream->members, id);
+}
+
+static int build_stream(
+    stream_member_index *index, ezxml_t node, int stream, int **seen,
+    int *seen_capacity
+) {
+    stream_entry *entry = &index->streams[stream];
+    const char *name = ezxml_attr(node, "name");
+    if (name != NULL) {
+        // Copied so that the index can outlive the ezxml tree
+        entry->name = strdup(name);
+        if (entry->name == NULL) {
+            return 1;
+        }
+    }
+
+    for (ezxml_t child = node->child; child != NULL; child = child->ordered) {
+        const char *tag = ezxml_name(child);
+        const char *name = ezxml_attr(child, "name");
+        if (name == NULL) {
+            continue;
+        }
+
+        if (strcmp(tag, "var") == 0 || strcmp(tag, "var_array") == 0) {
+            int id = intern_field(index, name);
+            if (id < 0 ||
+                add_member(entry, stream + 1, seen, seen_capacity, id)) {
+                return 1;
+            }
+        } else if (strcmp(tag, "file") == 0) {
+            int file = lookup_file(index, name);
+            if (file < 0) {
+                char msgbuf[MSGSIZE];
+                snprintf(
+                    msgbuf, MSGSIZE, "stream %s: cannot read file %s",
+                    entry->name != NULL ? entry->name : "(unnamed)", name
+                );
+                fmt_err(msgbuf);
+                return 1;
+            }
+            const id_list *members = &index->file_members[file];
+            for (int i = 0; i < members->n; i++) {
+                if (add_member(
+                    entry, stream + 1, seen, seen_capacity, members->ids[i]
+                )) {
+                    return 1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+int stream_member_index_build(ezxml_t streams, stream_member_index **index) {
+    *index = NULL;
+
+    stream_member_index *idx = calloc(1, sizeof(*idx));
+    if (idx == NULL) {
+        return 1;
+    }
+    if (table_init(&idx->fields, 128) || table_init(&idx->files, 16)) {
+        stream_member_index_free(idx);
+        return 1;
+    }
+
+    int n_streams = 0;
+    for (ezxml_t node = streams != NULL ? streams->child : NULL; node != NULL;
+         node = node->ordered) {
+        n_streams += is_stream(node);
+    }
+    idx->streams = calloc((size_t) (n_streams > 0 ? n_streams : 1),
+                          sizeof(stream_entry));
+    if (idx->streams == NULL) {
+        stream_member_index_free(idx);
+        return 1;
+    }
+
+    int *seen = NULL;
+    int seen_capacity = 0;
+    int ierr = 0;
+    for (ezxml_t node = streams != NULL ? streams->child : NULL; node != NULL;
+         node = node->ordered) {
+        if (!is_stream(node)) {
+            continue;
+        }
+        ierr = build_stream(idx, node, idx->n_streams++, &seen, &seen_capacity);
+        if (ierr) {
+            break;
+        }
+    }
+    free(seen);
+
+    if (ierr) {
+        stream_member_index_free(idx);
+        return 1;
+    }
+    *index = idx;
+    return 0;
+}
+
+void stream_member_index_free(stream_member_index *index) {
+    if (index == NULL) {
+        return;
+    }
+    for (int i = 0; i < index->n_fields; i++) {
+        free(index->field_names[i]);
+    }
+    free(index->field_names);
+    free(index->fields.slots);
+    for (int i = 0; i < index->n_files; i++) {
+        free(index->file_names[i]);
+        free(index->file_members[i].ids);
+    }
+    free(index->file_names);
+    free(index->file_members);
+    free(index->files.slots);
+    for (int i = 0; i < index->n_streams; i++) {
+        free(index->streams[i].name);
+        free(index->streams[i].members.ids);
+    }
+    free(index->streams);
+    free(index);
+}
+
+int stream_member_index_n_streams(const stream_member_index *index) {
+    return index->n_streams;
+}
+
+int stream_member_index_find_stream(
+    const stream_member_index *index, const char *stream_name
+) {
+    for (int i = 0; i < index->n_streams; i++) {
+        if (index->streams[i].name != NULL &&
+            strcmp(index->streams[i].name, stream_name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+const int *stream_member_index_members(
+    const stream_member_index *index, int stream, int *n_members
+) {
+    if (stream < 0 || stream >= index->n_streams) {
+        *n_members = 0;
+        return NULL;
+    }
+    *n_members = index->streams[stream].members.n;
+    return index->streams[stream].members.ids;
+}
+
+int stream_member_index_n_fields(const stream_member_index *index) {
+    return index->n_fields;
+}
+
+int stream_member_index_field_id(
+    const stream_member_index *index, const char *field_name
+) {
+    size_t slot = table_probe(&index->fields, index->field_names, field_name);
+    return index->fields.slots[slot] - 1;
+}
+
+const char *stream_member_index_field_name(
+    const stream_member_index *index, int field_id
+) {
+    if (field_id < 0 || field_id >= index->n_fields) {
+        return NULL;
+    }
+    return index->field_names[field_id];
+}
+
+int stream_member_index_n_files_read(const stream_member_index *index) {
+    return index->n_files;
+}
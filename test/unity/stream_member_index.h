@@ -0,0 +1,53 @@
+#ifndef STREAM_MEMBER_INDEX_H
+#define STREAM_MEMBER_INDEX_H
+
+#include "ezxml.h"
+
+// Flattened, deduplicated member table for every <stream> and
+// <immutable_stream> in a streams document.
+//
+// Member names from <var>, <var_array> and <file> children are interned once
+// into integer field IDs that are shared by all streams, so later resolution
+// against the field registry can be done by ID instead of by string compare.
+// Each <file> is read once, no matter how many streams include it.
+//
+// The index is meant to be built after check_streams() has accepted the
+// document; it does not repeat the attribute and uniqueness checks.
+
+typedef struct stream_member_index stream_member_index;
+
+// Returns 0 on success and nonzero if a <file> include cannot be read or
+// memory runs out; on failure *index is set to NULL. An unreadable include is
+// reported through fmt_err(). The index copies every name it keeps, so the
+// ezxml tree may be freed before the index.
+int stream_member_index_build(ezxml_t streams, stream_member_index **index);
+
+void stream_member_index_free(stream_member_index *index);
+
+int stream_member_index_n_streams(const stream_member_index *index);
+
+// Returns the position of the named stream in document order, or -1
+int stream_member_index_find_stream(
+    const stream_member_index *index, const char *stream_name
+);
+
+// Members of a stream as field IDs in first-seen order
+const int *stream_member_index_members(
+    const stream_member_index *index, int stream, int *n_members
+);
+
+int stream_member_index_n_fields(const stream_member_index *index);
+
+// Returns the field ID of an interned name, or -1
+int stream_member_index_field_id(
+    const stream_member_index *index, const char *field_name
+);
+
+const char *stream_member_index_field_name(
+    const stream_member_index *index, int field_id
+);
+
+// Number of distinct <file> includes that were read from disk
+int stream_member_index_n_files_read(const stream_member_index *index);
+
+#endif //STREAM_MEMBER_INDEX_H
@@ -0,0 +1,218 @@
+#include "unity.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "mpas_log_scan.h"
+
+static const char *rank0_log =
+        " Begin timestep 2010-10-23_00:03:00\n"
+        "  global min, max w -0.125 0.25\n"
+        "  global min, max u -40.5 51.75\n"
+        " Timing for integration step: 1.5 s\n"
+        " Begin timestep 2010-10-23_00:06:00\n"
+        "  global min, max w -0.5 0.75\n"
+        "  global min, max u -41.0 52.0\n"
+        " Timing for integration step: 0.5 s\n"
+        "\n"
+        "  Timer information:\n"
+        "    Globals are computed across all threads and processors\n"
+        "\n"
+        "    timer_name                                            total       calls        min            max            avg      pct_tot   pct_par     par_eff\n"
+        "  1 total time                                         10.00000         1     10.00000     10.00000     10.00000   100.00       0.00       1.00\n"
+        "  2  time integration                                   2.00000         1      2.00000      2.00000      2.00000    20.00      20.00       1.00\n"
+        "\n"
+        " -----------------------------------------\n"
+        " Total log messages printed:\n"
+        "    Output messages =                   12\n"
+        "    Warning messages =                   0\n"
+        "    Error messages =                     0\n"
+        "    Critical error messages =            0\n"
+        " -----------------------------------------\n";
+
+static const char *rank1_log =
+        " Timing for integration step: 2.5 s\n"
+        " Timing for integration step: 0.25 s\n"
+        "    timer_name                                            total       calls        min            max            avg      pct_tot   pct_par     par_eff\n"
+        "  1 total time                                         12.00000         1     12.00000     12.00000     12.00000   100.00       0.00       1.00\n"
+        "\n"
+        "    Error messages =                     2\n"
+        "    Critical error messages =            1\n";
+
+static void write_file(const char *path, const char *content) {
+    FILE *fp = fopen(path, "w");
+    TEST_ASSERT_NOT_NULL(fp);
+    fwrite(content, sizeof(char), strlen(content), fp);
+    fclose(fp);
+}
+
+void setUp(void) {
+    write_file("log.scan_test.0000.out", rank0_log);
+    write_file("log.scan_test.0001.out", rank1_log);
+}
+
+void tearDown(void) {
+    unlink("log.scan_test.0000.out");
+    unlink("log.scan_test.0001.out");
+    unlink("log.scan_test_long.0000.out");
+    unlink("log.scan_test_wide.0000.out");
+    unlink("log.scan_test_zero.0000.out");
+    unlink("log.scan_test_zero.0001.out");
+}
+
+void test_scan_single_file(void) {
+    mpas_log_summary summary;
+    TEST_ASSERT_EQUAL_INT(
+        0, mpas_log_scan_file("log.scan_test.0000.out", &summary)
+    );
+    TEST_ASSERT_EQUAL_INT(1, summary.files_scanned);
+    TEST_ASSERT_EQUAL_INT(0, summary.error_messages);
+    TEST_ASSERT_EQUAL_INT(0, summary.critical_error_messages);
+    TEST_ASSERT_EQUAL_INT(2, summary.n_timesteps);
+    TEST_ASSERT_EQUAL_DOUBLE(2.0, summary.step_time_total);
+    TEST_ASSERT_EQUAL_DOUBLE(0.5, summary.step_time_min);
+    TEST_ASSERT_EQUAL_DOUBLE(1.5, summary.step_time_max);
+    TEST_ASSERT_EQUAL_INT(1, summary.has_u_range);
+    TEST_ASSERT_EQUAL_DOUBLE(-41.0, summary.u_range[0]);
+    TEST_ASSERT_EQUAL_DOUBLE(52.0, summary.u_range[1]);
+    TEST_ASSERT_EQUAL_DOUBLE(-0.5, summary.w_range[0]);
+    TEST_ASSERT_EQUAL_DOUBLE(0.75, summary.w_range[1]);
+}
+
+void test_scan_timer_table(void) {
+    mpas_log_summary summary;
+    TEST_ASSERT_EQUAL_INT(
+        0, mpas_log_scan_file("log.scan_test.0000.out", &summary)
+    );
+    TEST_ASSERT_EQUAL_INT(2, summary.n_timers);
+    TEST_ASSERT_EQUAL_STRING("total time", summary.timers[0].name);
+    TEST_ASSERT_EQUAL_DOUBLE(10.0, summary.timers[0].total);
+    TEST_ASSERT_EQUAL_INT(1, summary.timers[0].calls);
+    TEST_ASSERT_EQUAL_STRING("time integration", summary.timers[1].name);
+    TEST_ASSERT_EQUAL_DOUBLE(2.0, summary.timers[1].total);
+}
+
+void test_scan_missing_file(void) {
+    mpas_log_summary summary;
+    TEST_ASSERT_NOT_EQUAL(
+        0, mpas_log_scan_file("log.does_not_exist.0000.out", &summary)
+    );
+    TEST_ASSERT_EQUAL_INT(-1, summary.error_messages);
+}
+
+void test_scan_line_longer_than_fortran_buffer(void) {
+    // Lines used to be read into a 256 character buffer and truncated
+    char content[4096];
+    char long_line[1024];
+    memset(long_line, 'x', sizeof(long_line) - 1);
+    long_line[sizeof(long_line) - 1] = '\0';
+    snprintf(
+        content, sizeof(content),
+        "%s\n    Error messages =                     3\n%s"
+        " Critical error messages = 4\n", long_line, long_line
+    );
+    write_file("log.scan_test_long.0000.out", content);
+
+    mpas_log_summary summary;
+    TEST_ASSERT_EQUAL_INT(
+        0, mpas_log_scan_file("log.scan_test_long.0000.out", &summary)
+    );
+    TEST_ASSERT_EQUAL_INT(3, summary.error_messages);
+    // The message is on the same line as the long prefix, not at its start
+    TEST_ASSERT_EQUAL_INT(-1, summary.critical_error_messages);
+}
+
+void test_scan_values_past_column_512(void) {
+    // Values are parsed from the whole line, not from a bounded copy of it:
+    // the timer total starts past column 256 and its call count past 512
+    char content[4096];
+    snprintf(
+        content, sizeof(content),
+        "    timer_name total calls min max avg\n"
+        "  1 %-300s%-230s%s\n"
+        "\n"
+        "    Error messages =%600s\n"
+        " Timing for integration step:%600s s\n",
+        "wide timer", "7.50000", "3     7.50000     7.50000     7.50000",
+        "5", "1.25"
+    );
+    write_file("log.scan_test_wide.0000.out", content);
+
+    mpas_log_summary summary;
+    TEST_ASSERT_EQUAL_INT(
+        0, mpas_log_scan_file("log.scan_test_wide.0000.out", &summary)
+    );
+    TEST_ASSERT_EQUAL_INT(1, summary.n_timers);
+    TEST_ASSERT_EQUAL_STRING("wide timer", summary.timers[0].name);
+    TEST_ASSERT_EQUAL_DOUBLE(7.5, summary.timers[0].total);
+    TEST_ASSERT_EQUAL_INT(3, summary.timers[0].calls);
+    TEST_ASSERT_EQUAL_INT(5, summary.error_messages);
+    TEST_ASSERT_EQUAL_INT(1, summary.n_timesteps);
+    TEST_ASSERT_EQUAL_DOUBLE(1.25, summary.step_time_max);
+}
+
+void test_scan_all_ranks(void) {
+    mpas_log_summary summary;
+    TEST_ASSERT_EQUAL_INT(
+        0, mpas_log_scan_files("log.scan_test", 2, 2, &summary)
+    );
+    TEST_ASSERT_EQUAL_INT(2, summary.files_scanned);
+    TEST_ASSERT_EQUAL_INT(2, summary.error_messages);
+    TEST_ASSERT_EQUAL_INT(1, summary.critical_error_messages);
+    TEST_ASSERT_EQUAL_INT(2, summary.n_timesteps);
+    TEST_ASSERT_EQUAL_DOUBLE(0.25, summary.step_time_min);
+    TEST_ASSERT_EQUAL_DOUBLE(2.5, summary.step_time_max);
+    // u/w ranges come from rank 0, timers take the max over ranks
+    TEST_ASSERT_EQUAL_DOUBLE(52.0, summary.u_range[1]);
+    TEST_ASSERT_EQUAL_STRING("total time", summary.timers[0].name);
+    TEST_ASSERT_EQUAL_DOUBLE(12.0, summary.timers[0].total);
+}
+
+void test_scan_zero_range_is_kept(void) {
+    // A real 0, 0 range on rank 0 must not be replaced by a later rank
+    write_file("log.scan_test_zero.0000.out", "  global min, max w 0.0 0.0\n");
+    write_file(
+        "log.scan_test_zero.0001.out",
+        "  global min, max w -0.5 0.75\n  global min, max u -41.0 52.0\n"
+    );
+
+    mpas_log_summary summary;
+    TEST_ASSERT_EQUAL_INT(
+        0, mpas_log_scan_files("log.scan_test_zero", 2, 2, &summary)
+    );
+    TEST_ASSERT_EQUAL_INT(1, summary.has_w_range);
+    TEST_ASSERT_EQUAL_DOUBLE(0.0, summary.w_range[0]);
+    TEST_ASSERT_EQUAL_DOUBLE(0.0, summary.w_range[1]);
+    // Rank 0 reports no u range, so it comes from rank 1
+    TEST_ASSERT_EQUAL_INT(1, summary.has_u_range);
+    TEST_ASSERT_EQUAL_DOUBLE(52.0, summary.u_range[1]);
+}
+
+void test_scan_skips_ranks_without_log(void) {
+    mpas_log_summary summary;
+    TEST_ASSERT_EQUAL_INT(
+        0, mpas_log_scan_files("log.scan_test", 4, 0, &summary)
+    );
+    TEST_ASSERT_EQUAL_INT(2, summary.files_scanned);
+}
+
+void test_scan_missing_rank0_fails(void) {
+    mpas_log_summary summary;
+    TEST_ASSERT_NOT_EQUAL(
+        0, mpas_log_scan_files("log.does_not_exist", 2, 0, &summary)
+    );
+    TEST_ASSERT_EQUAL_INT(0, summary.files_scanned);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_scan_single_file);
+    RUN_TEST(test_scan_timer_table);
+    RUN_TEST(test_scan_missing_file);
+    RUN_TEST(test_scan_line_longer_than_fortran_buffer);
+    RUN_TEST(test_scan_values_past_column_512);
+    RUN_TEST(test_scan_all_ranks);
+    RUN_TEST(test_scan_zero_range_is_kept);
+    RUN_TEST(test_scan_skips_ranks_without_log);
+    RUN_TEST(test_scan_missing_rank0_fails);
+    return UNITY_END();
+}
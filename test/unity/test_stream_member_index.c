@@ -0,0 +1,223 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "unity.h"
+#include "ezxml.h"
+#include "stream_member_index.h"
+
+static const char *shared_file = "test_stream_members_shared.txt";
+static const char *large_file = "test_stream_members_large.txt";
+
+static void write_file(const char *path, const char *content) {
+    FILE *fp = fopen(path, "w");
+    TEST_ASSERT_NOT_NULL(fp);
+    fwrite(content, sizeof(char), strlen(content), fp);
+    fclose(fp);
+}
+
+static char last_err[256];
+
+// Stands in for the MPAS logger, which is not initialized in this test
+void fmt_err(const char *msg) {
+    snprintf(last_err, sizeof(last_err), "%s", msg);
+}
+
+static ezxml_t make_streams(const char *xml) {
+    return ezxml_parse_str(strdup(xml), strlen(xml));
+}
+
+void setUp(void) {
+    last_err[0] = '\0';
+    write_file(shared_file, "theta\nrho\n  u  \n\ntheta\n");
+}
+
+void tearDown(void) {
+    unlink(shared_file);
+    unlink(large_file);
+}
+
+void test_members_are_deduplicated(void) {
+    const char *xml = "<streams>"
+            "  <stream name=\"out\" type=\"output\" filename_template=\"out.nc\" output_interval=\"1\">"
+            "    <var name=\"u\"/>"
+            "    <var_array name=\"scalars\"/>"
+            "    <var name=\"u\"/>"
+            "    <var name=\"w\"/>"
+            "  </stream>"
+            "</streams>";
+    ezxml_t root = make_streams(xml);
+    stream_member_index *index;
+    TEST_ASSERT_EQUAL_INT(0, stream_member_index_build(root, &index));
+
+    int n;
+    const int *members = stream_member_index_members(index, 0, &n);
+    TEST_ASSERT_EQUAL_INT(3, n);
+    TEST_ASSERT_EQUAL_STRING("u", stream_member_index_field_name(index, members[0]));
+    TEST_ASSERT_EQUAL_STRING("scalars", stream_member_index_field_name(index, members[1]));
+    TEST_ASSERT_EQUAL_STRING("w", stream_member_index_field_name(index, members[2]));
+
+    stream_member_index_free(index);
+    ezxml_free(root);
+}
+
+void test_field_ids_are_shared_between_streams(void) {
+    const char *xml = "<streams>"
+            "  <stream name=\"a\" type=\"output\" filename_template=\"a.nc\" output_interval=\"1\">"
+            "    <var name=\"u\"/><var name=\"w\"/>"
+            "  </stream>"
+            "  <immutable_stream name=\"init\" type=\"input\" filename_template=\"init.nc\" input_interval=\"initial_only\"/>"
+            "  <stream name=\"b\" type=\"output\" filename_template=\"b.nc\" output_interval=\"1\">"
+            "    <var name=\"w\"/><var name=\"qv\"/>"
+            "  </stream>"
+            "</streams>";
+    ezxml_t root = make_streams(xml);
+    stream_member_index *index;
+    TEST_ASSERT_EQUAL_INT(0, stream_member_index_build(root, &index));
+
+    TEST_ASSERT_EQUAL_INT(3, stream_member_index_n_streams(index));
+    TEST_ASSERT_EQUAL_INT(3, stream_member_index_n_fields(index));
+    TEST_ASSERT_EQUAL_INT(1, stream_member_index_find_stream(index, "init"));
+    TEST_ASSERT_EQUAL_INT(-1, stream_member_index_find_stream(index, "missing"));
+
+    int n_a, n_init, n_b;
+    const int *a = stream_member_index_members(index, 0, &n_a);
+    stream_member_index_members(index, 1, &n_init);
+    const int *b = stream_member_index_members(index, 2, &n_b);
+    TEST_ASSERT_EQUAL_INT(2, n_a);
+    TEST_ASSERT_EQUAL_INT(0, n_init);
+    TEST_ASSERT_EQUAL_INT(2, n_b);
+    TEST_ASSERT_EQUAL_INT(a[1], b[0]);
+    TEST_ASSERT_EQUAL_INT(stream_member_index_field_id(index, "w"), a[1]);
+    TEST_ASSERT_EQUAL_INT(-1, stream_member_index_field_id(index, "nonexistent"));
+
+    stream_member_index_free(index);
+    ezxml_free(root);
+}
+
+void test_file_include_is_read_once(void) {
+    const char *xml = "<streams>"
+            "  <stream name=\"a\" type=\"output\" filename_template=\"a.nc\" output_interval=\"1\">"
+            "    <file name=\"test_stream_members_shared.txt\"/>"
+            "  </stream>"
+            "  <stream name=\"b\" type=\"output\" filename_template=\"b.nc\" output_interval=\"1\">"
+            "    <var name=\"u\"/>"
+            "    <file name=\"test_stream_members_shared.txt\"/>"
+            "    <var name=\"w\"/>"
+            "  </stream>"
+            "</streams>";
+    ezxml_t root = make_streams(xml);
+    stream_member_index *index;
+    TEST_ASSERT_EQUAL_INT(0, stream_member_index_build(root, &index));
+
+    TEST_ASSERT_EQUAL_INT(1, stream_member_index_n_files_read(index));
+
+    int n_a, n_b;
+    stream_member_index_members(index, 0, &n_a);
+    const int *b = stream_member_index_members(index, 1, &n_b);
+    // theta, rho, u from the file; the repeated theta is dropped
+    TEST_ASSERT_EQUAL_INT(3, n_a);
+    // u, theta, rho, w; u from the file is already a member
+    TEST_ASSERT_EQUAL_INT(4, n_b);
+    TEST_ASSERT_EQUAL_STRING("u", stream_member_index_field_name(index, b[0]));
+    TEST_ASSERT_EQUAL_STRING("theta", stream_member_index_field_name(index, b[1]));
+    TEST_ASSERT_EQUAL_STRING("rho", stream_member_index_field_name(index, b[2]));
+    TEST_ASSERT_EQUAL_STRING("w", stream_member_index_field_name(index, b[3]));
+
+    stream_member_index_free(index);
+    ezxml_free(root);
+}
+
+void test_unreadable_file_include_fails(void) {
+    const char *xml = "<streams>"
+            "  <stream name=\"sfile\" type=\"input\" filename_template=\"sfile.nc\" input_interval=\"0_01:00:00\">"
+            "    <file name=\"nonexistent.txt\"/>"
+            "  </stream>"
+            "</streams>";
+    ezxml_t root = make_streams(xml);
+    stream_member_index *index = (stream_member_index *) 1;
+    TEST_ASSERT_NOT_EQUAL(0, stream_member_index_build(root, &index));
+    TEST_ASSERT_NULL(index);
+    TEST_ASSERT_EQUAL_STRING(
+        "stream sfile: cannot read file nonexistent.txt", last_err
+    );
+    ezxml_free(root);
+}
+
+void test_thousands_of_members(void) {
+    const int n_fields = 5000;
+    char name[32];
+
+    FILE *fp = fopen(large_file, "w");
+    TEST_ASSERT_NOT_NULL(fp);
+    for (int i = 0; i < n_fields; i++) {
+        fprintf(fp, "field_%d\n", i);
+    }
+    fclose(fp);
+
+    // Every stream includes the file and repeats a slice of it as <var>s
+    size_t xml_len = 64 * (size_t) n_fields + 4096;
+    char *xml = malloc(xml_len);
+    TEST_ASSERT_NOT_NULL(xml);
+    size_t off = (size_t) snprintf(xml, xml_len, "<streams>");
+    for (int s = 0; s < 4; s++) {
+        off += (size_t) snprintf(
+            xml + off, xml_len - off,
+            "<stream name=\"s%d\"><file name=\"%s\"/>", s, large_file
+        );
+        for (int i = s * 1000; i < (s + 1) * 1000; i++) {
+            snprintf(name, sizeof(name), "field_%d", i);
+            off += (size_t) snprintf(
+                xml + off, xml_len - off, "<var name=\"%s\"/>", name
+            );
+        }
+        off += (size_t) snprintf(xml + off, xml_len - off, "</stream>");
+    }
+    snprintf(xml + off, xml_len - off, "</streams>");
+
+    ezxml_t root = make_streams(xml);
+    stream_member_index *index;
+    TEST_ASSERT_EQUAL_INT(0, stream_member_index_build(root, &index));
+    TEST_ASSERT_EQUAL_INT(1, stream_member_index_n_files_read(index));
+    TEST_ASSERT_EQUAL_INT(n_fields, stream_member_index_n_fields(index));
+    for (int s = 0; s < 4; s++) {
+        int n;
+        stream_member_index_members(index, s, &n);
+        TEST_ASSERT_EQUAL_INT(n_fields, n);
+    }
+
+    stream_member_index_free(index);
+    ezxml_free(root);
+    free(xml);
+}
+
+void test_index_outlives_tree(void) {
+    const char *xml = "<streams>"
+            "  <immutable_stream name=\"input\" type=\"input\" filename_template=\"in.nc\" input_interval=\"initial_only\"/>"
+            "  <stream name=\"out\" type=\"output\" filename_template=\"out.nc\" output_interval=\"1\">"
+            "    <var name=\"u\"/>"
+            "  </stream>"
+            "</streams>";
+    ezxml_t root = make_streams(xml);
+    stream_member_index *index;
+    TEST_ASSERT_EQUAL_INT(0, stream_member_index_build(root, &index));
+    ezxml_free(root);
+
+    TEST_ASSERT_EQUAL_INT(1, stream_member_index_find_stream(index, "out"));
+    TEST_ASSERT_EQUAL_INT(0, stream_member_index_find_stream(index, "input"));
+    TEST_ASSERT_EQUAL_STRING("u", stream_member_index_field_name(index, 0));
+
+    stream_member_index_free(index);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_members_are_deduplicated);
+    RUN_TEST(test_field_ids_are_shared_between_streams);
+    RUN_TEST(test_file_include_is_read_once);
+    RUN_TEST(test_unreadable_file_include_fails);
+    RUN_TEST(test_thousands_of_members);
+    RUN_TEST(test_index_outlives_tree);
+    return UNITY_END();
+}